@@ -0,0 +1,142 @@
+#!/bin/bash
+#Golden-output check of the optimized paths against the default serial path on a synthetic .dat
+#Each mode (fit cache replay, bounded memory, reader pipeline w/ + w/o a memory budget, event shards + merge) must reproduce the default output w/in tolerance
+#The run DB must replace, not duplicate or zero, the summary of a re-created output
+#Optional reference check: GOLDENCONFIG=<config> GOLDENREF=<reference output .root> bash/runValidation.sh
+#Run via 'make validate' or directly after 'make'
+
+if [[ -z $SPHENIXADCDIR ]]
+then
+    echo "SPHENIXADCDIR not set; source setEnv.sh. exit 1"
+    exit 1
+fi
+
+cd $SPHENIXADCDIR
+
+DATE=$(date +%Y%m%d)
+OUTDIR=output/validation
+NSTEPS=4
+NEVENTSPERSTEP=20
+NSAMPLE=28
+NEVENTS=$((NSTEPS*NEVENTSPERSTEP))
+RELTOL=1e-5
+ABSTOL=1e-6
+
+rm -rf $OUTDIR
+mkdir -p $OUTDIR
+
+nFail=0
+
+#Writes a config w/ the shared keys + any extra 'KEY: value' lines given as arguments
+writeConfig () {
+    configName=$1
+    outName=$2
+    shift 2
+    echo "INFILENAME: $OUTDIR/synth.dat" > $configName
+    echo "OUTFILENAME: $outName" >> $configName
+    echo "SAVEEXT: png" >> $configName
+    echo "MINCHANNEL: 0" >> $configName
+    echo "MAXCHANNEL: 7" >> $configName
+    echo "GLOBALMAX: 20000" >> $configName
+    echo "LINRESMAX: 5000" >> $configName
+    echo "LINRESMIN: 0" >> $configName
+    for line in "$@"
+    do
+	echo "$line" >> $configName
+    done
+}
+
+runCompare () {
+    ./bin/sphenixADCCompare.exe $OUTDIR/synth_default_$DATE.root $1 $2 $ABSTOL
+    if [[ $? -ne 0 ]]
+    then
+	nFail=$((nFail+1))
+    fi
+}
+
+./bin/sphenixADCSynth.exe $OUTDIR/synth.dat $NSTEPS $NEVENTSPERSTEP $NSAMPLE
+
+#Reference - default serial path
+writeConfig $OUTDIR/default.config $OUTDIR/synth_default.root
+./bin/sphenixADCProcessing.exe $OUTDIR/default.config
+
+#Fit cache - first pass fills, second pass replays every fit from the cache
+writeConfig $OUTDIR/cache.config $OUTDIR/synth_cache.root "CACHEDIR: $OUTDIR/cache"
+./bin/sphenixADCProcessing.exe $OUTDIR/cache.config
+./bin/sphenixADCProcessing.exe $OUTDIR/cache.config
+runCompare $OUTDIR/synth_cache_$DATE.root $RELTOL
+
+#Bounded memory - budget small enough that per-event keys are skipped + steps are flushed as they complete
+writeConfig $OUTDIR/bounded.config $OUTDIR/synth_bounded.root "MEMBUDGETMB: 1"
+./bin/sphenixADCProcessing.exe $OUTDIR/bounded.config
+runCompare $OUTDIR/synth_bounded_$DATE.root $RELTOL
+
+#Reader/decoder on its own thread; a depth of 2 forces frequent backpressure
+writeConfig $OUTDIR/pipeline.config $OUTDIR/synth_pipeline.root "PIPELINEDEPTH: 2" "METRICSFILENAME: $OUTDIR/pipeline.prom" "METRICSINTERVAL: 1"
+./bin/sphenixADCProcessing.exe $OUTDIR/pipeline.config
+runCompare $OUTDIR/synth_pipeline_$DATE.root $RELTOL
+
+#Pipelined + bounded memory - reader, fit + writer threads w/ steps flushed as they complete
+writeConfig $OUTDIR/pipebounded.config $OUTDIR/synth_pipebounded.root "PIPELINEDEPTH: 2" "MEMBUDGETMB: 1"
+./bin/sphenixADCProcessing.exe $OUTDIR/pipebounded.config
+runCompare $OUTDIR/synth_pipebounded_$DATE.root $RELTOL
+
+#Two step-aligned shards + merge
+./bin/sphenixADCIndexer.exe $OUTDIR/synth.dat $OUTDIR/synth.idx 2
+HALF=$(((NSTEPS/2)*NEVENTSPERSTEP))
+writeConfig $OUTDIR/shard0.config $OUTDIR/synth_shard.root "INDEXFILENAME: $OUTDIR/synth.idx" "EVENTSTART: 0" "EVENTEND: $HALF"
+writeConfig $OUTDIR/shard1.config $OUTDIR/synth_shard.root "INDEXFILENAME: $OUTDIR/synth.idx" "EVENTSTART: $HALF" "EVENTEND: $NEVENTS"
+./bin/sphenixADCProcessing.exe $OUTDIR/shard0.config
+./bin/sphenixADCProcessing.exe $OUTDIR/shard1.config
+echo "MERGEFILENAMES: $OUTDIR/synth_shard_Evt0to${HALF}_$DATE.root,$OUTDIR/synth_shard_Evt${HALF}to${NEVENTS}_$DATE.root" > $OUTDIR/merge.config
+echo "OUTFILENAME: $OUTDIR/synth_merged.root" >> $OUTDIR/merge.config
+echo "SAVEEXT: png" >> $OUTDIR/merge.config
+echo "LINRESMAX: 5000" >> $OUTDIR/merge.config
+echo "LINRESMIN: 0" >> $OUTDIR/merge.config
+./bin/sphenixADCMerge.exe $OUTDIR/merge.config
+runCompare $OUTDIR/synth_merged_$DATE.root $RELTOL
+
+#Run DB - same output name re-created (same config re-run the same day) must replace its summary w/ the same values, leaving other runs intact
+RUNDB=$OUTDIR/runDB.root
+writeConfig $OUTDIR/rundb.config $OUTDIR/synth_rundb.root "RUNDBFILENAME: $RUNDB"
+./bin/sphenixADCProcessing.exe $OUTDIR/rundb.config
+./bin/sphenixADCRunDB.exe add $RUNDB $OUTDIR/synth_default_$DATE.root
+#Rows are sorted since the two runs share a runDate + the index order among equal keys is not fixed
+firstRows=$(./bin/sphenixADCRunDB.exe query $RUNDB 0 0 | grep "\.root$" | sort)
+#Creation time has 1 s resolution; wait so the re-run is seen as re-created, not a duplicate
+sleep 1
+./bin/sphenixADCProcessing.exe $OUTDIR/rundb.config
+secondRows=$(./bin/sphenixADCRunDB.exe query $RUNDB 0 0 | grep "\.root$" | sort)
+nRunDBRows=$(echo "$secondRows" | grep -c "synth_rundb_$DATE.root$")
+runDBSlope=$(echo "$secondRows" | grep "synth_rundb_$DATE.root$" | awk '{print $2}')
+if [[ $nRunDBRows -ne 1 || "$firstRows" != "$secondRows" || -z $runDBSlope || $runDBSlope == "0" ]]
+then
+    echo "RUNDB MISMATCH - re-created '$OUTDIR/synth_rundb_$DATE.root' gave $nRunDBRows rows"
+    echo "Before re-create:"
+    echo "$firstRows"
+    echo "After re-create:"
+    echo "$secondRows"
+    nFail=$((nFail+1))
+fi
+
+#Reference input - rerun the given config into $OUTDIR + compare to the stored reference output
+if [[ -n $GOLDENCONFIG && -n $GOLDENREF ]]
+then
+    grep -v "^OUTFILENAME" $GOLDENCONFIG > $OUTDIR/golden.config
+    echo "OUTFILENAME: $OUTDIR/golden.root" >> $OUTDIR/golden.config
+    ./bin/sphenixADCProcessing.exe $OUTDIR/golden.config
+    ./bin/sphenixADCCompare.exe $GOLDENREF $OUTDIR/golden_$DATE.root $RELTOL $ABSTOL
+    if [[ $? -ne 0 ]]
+    then
+	nFail=$((nFail+1))
+    fi
+fi
+
+if [[ $nFail -ne 0 ]]
+then
+    echo "VALIDATION FAILED: $nFail comparisons outside tolerance. exit 1"
+    exit 1
+fi
+
+echo "VALIDATION PASSED. exit 0"
+exit 0
@@ -0,0 +1,50 @@
+#ifndef ADCEVENTREADER_H
+#define ADCEVENTREADER_H
+
+//cpp
+#include <istream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+//The following is hard-coded in sphenix_adc_test_jseb2.c - 64 channels, 2 per 32-bit word
+const int nADCEventChannels = 64;
+const int nADCEventMaxSamples = 50;
+
+//Decoded samples for one event; fixed size so it passes through spscQueue w/o allocation
+struct adcEventData{
+  int eventI;
+  unsigned int adc[nADCEventChannels][nADCEventMaxSamples];
+};
+
+//Read + decode stages for a sphenix_adc_test_jseb2 .dat positioned after the 4 header lines (or seeked to an indexed event)
+//Events are blank-line terminated; same boundaries as buildEventIndex, so event numbers agree w/ sharding
+class adcEventReader
+{
+ public:
+  adcEventReader(std::istream* inStream_p, const int inNSample, const int inEventStart, const int inEventEnd);
+  ~adcEventReader(){};
+
+  //false at end of file or once inEventEnd is reached
+  bool Next(adcEventData* event);
+
+  int GetNRead(){return m_nextEvent - m_eventStart;}
+
+ private:
+  void decode(adcEventData* event);
+
+  static const std::size_t nLineValsMax = 8;
+
+  std::istream* m_inStream_p;
+  int m_nSample;
+  int m_eventStart;
+  int m_eventEnd;
+  int m_nextEvent;
+  int m_nLine;
+  bool m_prevLineStrZero;
+  std::string m_lineStr;
+  std::vector<unsigned int> m_readVect;
+  std::string_view m_lineVals[nLineValsMax];
+};
+
+#endif
@@ -0,0 +1,181 @@
+#ifndef ADCRESPONSEUTIL_H
+#define ADCRESPONSEUTIL_H
+
+//c+cpp
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <vector>
+
+//ROOT
+#include "TCanvas.h"
+#include "TDirectory.h"
+#include "TFile.h"
+#include "TH1F.h"
+#include "TLatex.h"
+#include "TStyle.h"
+
+//Local
+#include "include/plotUtilities.h"
+
+inline std::string getADCResponseChannelStr(const int channel)
+{
+  std::string channelStr = std::to_string(channel);
+  if(channel < 10) channelStr = "0" + channelStr;
+  return "Channel" + channelStr;
+}
+
+inline std::string getADCResponseDistribName(const int channel, const int step){return "adc" + getADCResponseChannelStr(channel) + "_Step" + std::to_string(step) + "_h";}
+
+//Peak distribution for one (channel, step); created in the current directory, caller owns it
+//Style is set here rather than at draw time so distributions written per-step (bounded-memory mode) match
+inline TH1F* buildADCResponseDistrib(const int channel, const int step, std::vector<Float_t>* peaks)
+{
+  std::vector<float> tempVect = (*peaks);
+
+  std::sort(std::begin(tempVect), std::end(tempVect));
+
+  TH1F* distrib_p = nullptr;
+  if(tempVect.size() == 0){
+    std::cout << "BUILDADCRESPONSEDISTRIB WARNING - Channel " << channel << ", step " << step << " has no peaks; filling empty distribution" << std::endl;
+    distrib_p = new TH1F(getADCResponseDistribName(channel, step).c_str(), (";ADC (Step=" + std::to_string(step) + ");Counts").c_str(), 20, 0.0, 1.0);
+  }
+  else{
+    double delta = tempVect[tempVect.size()-1] - tempVect[0];
+
+    distrib_p = new TH1F(getADCResponseDistribName(channel, step).c_str(), (";ADC (Step=" + std::to_string(step) + ");Counts").c_str(), 20, tempVect[0] - delta/10., tempVect[tempVect.size()-1] + delta/10.);
+
+    for(unsigned int tI = 0; tI < tempVect.size(); ++tI){
+      distrib_p->Fill(tempVect[tI]);
+    }
+  }
+
+  distrib_p->SetMarkerStyle(24);
+  distrib_p->SetMarkerSize(1.1);
+  distrib_p->SetLineColor(1);
+  distrib_p->SetMarkerColor(1);
+
+  distrib_p->SetMinimum(0.0);
+
+  return distrib_p;
+}
+
+//Builds per-step peak distributions + the step response curve for each channel from the collected peak values
+//Shared by sphenixADCProcessing (single-process) and sphenixADCMerge (sharded) so both produce identical output
+//distribVect == nullptr means the step distributions were already written per-step (bounded-memory mode) and are read back one channel at a time
+inline void fillADCResponse(TFile* outFile_p, std::vector<TDirectory*>* dir_p, const int minChannel, const int maxChannel, const int nSteps, std::vector<std::vector<std::vector<Float_t> > >* distribVect, const std::string dateStr, const std::string saveExt, const Float_t linResMin, const Float_t linResMax)
+{
+  outFile_p->cd();
+
+  for(Int_t i = minChannel; i <= maxChannel; ++i){
+    outFile_p->cd();
+    (*dir_p)[i - minChannel]->cd();
+
+    std::string channelStr = getADCResponseChannelStr(i);
+
+    TH1F* adcResponse_p = new TH1F(("adcResponse_" + channelStr + "_h").c_str(), ";Step;Signal", nSteps, -0.5, ((Float_t)nSteps) - 0.5);
+    std::vector<TH1F*> adcResponse_Distrib_p;
+
+    for(Int_t sI = 0; sI < nSteps; ++sI){
+      if(distribVect != nullptr) adcResponse_Distrib_p.push_back(buildADCResponseDistrib(i, sI, &((*distribVect)[i - minChannel][sI])));
+      else{
+	TH1F* distrib_p = (TH1F*)(*dir_p)[i - minChannel]->Get(getADCResponseDistribName(i, sI).c_str());
+	if(distrib_p == nullptr){
+	  std::vector<Float_t> emptyVect;
+	  distrib_p = buildADCResponseDistrib(i, sI, &emptyVect);
+	  distrib_p->Write("", TObject::kOverwrite);
+	}
+	adcResponse_Distrib_p.push_back(distrib_p);
+      }
+
+      Float_t mean = adcResponse_Distrib_p[sI]->GetMean();
+      Float_t meanErr = adcResponse_Distrib_p[sI]->GetMeanError();
+
+      adcResponse_p->SetBinContent(sI+1, mean);
+      adcResponse_p->SetBinError(sI+1, meanErr);
+    }
+
+    const Int_t nX = 8;
+    const Int_t nY = 5;
+
+    if(nX*nY >= nSteps){
+      TCanvas* canv_p = new TCanvas("canv_p", "", nX*200 + nY*200);
+      canv_p->SetTopMargin(0.01);
+      canv_p->SetBottomMargin(0.01);
+      canv_p->SetRightMargin(0.01);
+      canv_p->SetLeftMargin(0.01);
+
+      canv_p->Divide(nX, nY);
+
+      for(Int_t sI = 0; sI < nSteps; ++sI){
+	canv_p->cd();
+	canv_p->cd(sI+1);
+
+	adcResponse_Distrib_p[sI]->DrawCopy("HIST E1 P");
+      }
+
+      std::string saveName = "pdfDir/" + dateStr + "/adcResponse_" + channelStr + "_Distrib_" + dateStr + "." + saveExt;
+      quietSaveAs(canv_p, saveName.c_str());
+      delete canv_p;
+    }
+    else std::cout << "Dimensions nX*nY=" << nX << "*" << nY << "=" << nX*nY << " is less than needed " << nSteps << ". skipping..." << std::endl;
+
+    outFile_p->cd();
+    (*dir_p)[i - minChannel]->cd();
+
+    for(Int_t sI = 0; sI < nSteps; ++sI){
+      if(distribVect != nullptr) adcResponse_Distrib_p[sI]->Write("", TObject::kOverwrite);
+      delete adcResponse_Distrib_p[sI];
+    }
+
+    adcResponse_p->Write("", TObject::kOverwrite);
+
+    TCanvas* canv_p = new TCanvas("canv_p", "", 900, 900);
+    canv_p->SetLeftMargin(0.14);
+    canv_p->SetBottomMargin(0.14);
+    canv_p->SetRightMargin(0.01);
+    canv_p->SetTopMargin(0.01);
+
+    adcResponse_p->SetMinimum(0.0);
+    adcResponse_p->GetYaxis()->SetNdivisions(404);
+
+    std::string xTitle = adcResponse_p->GetXaxis()->GetTitle();
+    std::string yTitle = adcResponse_p->GetYaxis()->GetTitle();
+
+    xTitle = "#bf{" + xTitle + "}";
+    yTitle = "#bf{" + yTitle + "}";
+
+    adcResponse_p->GetXaxis()->SetTitle(xTitle.c_str());
+    adcResponse_p->GetYaxis()->SetTitle(yTitle.c_str());
+
+    adcResponse_p->SetMaximum(linResMax);
+    adcResponse_p->SetMinimum(linResMin);
+
+    std::string nChannelStr = std::to_string(i);
+    if(i < 10) nChannelStr = "0" + nChannelStr;
+
+    adcResponse_p->SetMarkerStyle(21);
+    adcResponse_p->SetMarkerSize(1.5);
+    adcResponse_p->SetMarkerColor(1);
+    adcResponse_p->SetLineColor(1);
+
+    TLatex* label_p = new TLatex();
+    label_p->SetNDC();
+
+    adcResponse_p->DrawCopy("HIST E1 P");
+
+    label_p->DrawLatex(0.2, 0.8, ("Channel " + std::to_string(i)).c_str());
+
+    gStyle->SetOptStat(0);
+    quietSaveAs(canv_p, "pdfDir/" + dateStr + "/response_Channel" + nChannelStr + "_" + dateStr + "." + saveExt);
+
+    delete canv_p;
+    delete label_p;
+
+    delete adcResponse_p;
+  }
+
+  return;
+}
+
+#endif
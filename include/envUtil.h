@@ -5,6 +5,7 @@
 #include <iostream>
 #include <map>
 #include <string>
+#include <string_view>
 #include <vector>
 
 //ROOT
@@ -20,15 +21,8 @@ inline bool checkEnvForParams(TEnv* inEnv_p, std::vector<std::string> inParams)
   bool retVal = true;
 
   for(auto const & param : inParams){
-    bool isFound = false;
-
-    for(Int_t entry = 0; entry < hash_p->GetEntries(); ++entry){
-      std::string name = hash_p->At(entry)->GetName();
-      if(isStrSame(name, param)){
-        isFound = true;
-        break;
-      }
-    }
+    //Hashed lookup on the TEnv table, same as TEnv::Lookup
+    bool isFound = hash_p->FindObject(param.c_str()) != nullptr;
 
     if(!isFound){
       std::cout << "PLOTMAKING ERROR - Missing required parameter \'" << param << "\'. return false" << std::endl;
@@ -44,36 +38,8 @@ inline bool compEnvParams(TEnv* inEnv1_p, TEnv* inEnv2_p, std::vector<std::strin
   bool retVal = true;
 
   for(auto const & param : inParams){
-    std::string val1 = inEnv1_p->GetValue(param.c_str(), "");
-    std::string val2 = inEnv2_p->GetValue(param.c_str(), "");
-
-    if(val1.size() != 0){
-      while(val1.substr(0,1).find(" ") != std::string::npos){
-	val1.replace(0, 1, "");
-	if(val1.size() == 0) break;
-      }
-
-      if(val1.size() != 0){
-	while(val1.substr(val1.size()-1,1).find(" ") != std::string::npos){
-	  val1.replace(val1.size()-1, 1, "");
-	  if(val1.size() == 0) break;
-	}
-      }
-    }
-    
-    if(val2.size() != 0){
-      while(val2.substr(0,1).find(" ") != std::string::npos){
-	val2.replace(0, 1, "");
-	if(val2.size() == 0) break;
-      }
-
-      if(val2.size() != 0){
-	while(val2.substr(val2.size()-1,1).find(" ") != std::string::npos){
-	  val2.replace(val2.size()-1, 1, "");
-	  if(val2.size() == 0) break;
-	}
-      }
-    }
+    std::string_view val1 = strViewTrim(inEnv1_p->GetValue(param.c_str(), ""));
+    std::string_view val2 = strViewTrim(inEnv2_p->GetValue(param.c_str(), ""));
     
     if(isStrSame(val1, val2)) continue;
 
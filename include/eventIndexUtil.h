@@ -0,0 +1,148 @@
+#ifndef EVENTINDEXUTIL_H
+#define EVENTINDEXUTIL_H
+
+//c+cpp
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <vector>
+
+//Byte-offset index of event boundaries in a sphenix_adc_test_jseb2 .dat file
+//Offset i points at the first line of event i; only events terminated by a blank line are indexed, matching sphenixADCProcessing
+//Index file format (text):
+// line 1: nSteps nEventsPerStep nADCPerStep nSample inFileSize [inFileMD5]
+// line 2+: eventI byteOffset
+//inFileSize (bytes) ties the index to its input - scans w/ identical header params otherwise look the same
+//inFileMD5 is optional (sphenixADCIndexer writes it) + lets shards key the fit cache w/o re-reading the whole input
+
+//0 if the file cannot be stat'd
+inline unsigned long long getEventIndexFileSize(const std::string inFileName)
+{
+  struct stat st;
+  if(stat(inFileName.c_str(), &st) != 0) return 0;
+  return (unsigned long long)st.st_size;
+}
+
+inline bool buildEventIndex(const std::string inFileName, std::vector<int>* header, unsigned long long* fileSize, std::vector<unsigned long long>* offsets)
+{
+  std::ifstream inFile(inFileName.c_str());
+  if(!inFile.is_open()){
+    std::cout << "BUILDEVENTINDEX ERROR - Cannot open \'" << inFileName << "\'. return false" << std::endl;
+    return false;
+  }
+
+  header->clear();
+  offsets->clear();
+  (*fileSize) = getEventIndexFileSize(inFileName);
+
+  std::string lineStr;
+  //4 manual calls for the overhead info, same as sphenixADCProcessing
+  for(unsigned int hI = 0; hI < 4; ++hI){
+    if(!std::getline(inFile, lineStr)){
+      std::cout << "BUILDEVENTINDEX ERROR - \'" << inFileName << "\' is missing header lines. return false" << std::endl;
+      return false;
+    }
+    header->push_back(std::stoi(lineStr));
+  }
+
+  bool prevLineStrZero = false;
+  bool inEvent = false;
+  unsigned long long eventStart = 0;
+  unsigned long long lineStart = inFile.tellg();
+
+  while(std::getline(inFile, lineStr)){
+    //Same whitespace handling as the processing loop - only leading spaces are stripped
+    std::string::size_type firstNonSpace = lineStr.find_first_not_of(" ");
+
+    if(firstNonSpace == std::string::npos){
+      if(!prevLineStrZero){
+	prevLineStrZero = true;
+	if(inEvent) offsets->push_back(eventStart);
+	inEvent = false;
+      }
+    }
+    else{
+      prevLineStrZero = false;
+      if(!inEvent){
+	eventStart = lineStart;
+	inEvent = true;
+      }
+    }
+
+    lineStart = inFile.tellg();
+  }
+
+  inFile.close();
+  return true;
+}
+
+inline bool writeEventIndex(const std::string outFileName, std::vector<int>* header, const unsigned long long fileSize, const std::string fileMD5, std::vector<unsigned long long>* offsets)
+{
+  std::ofstream outFile(outFileName.c_str());
+  if(!outFile.is_open()){
+    std::cout << "WRITEEVENTINDEX ERROR - Cannot open \'" << outFileName << "\'. return false" << std::endl;
+    return false;
+  }
+
+  for(unsigned int hI = 0; hI < header->size(); ++hI){
+    outFile << (*header)[hI] << " ";
+  }
+  outFile << fileSize;
+  if(fileMD5.size() != 0) outFile << " " << fileMD5;
+  outFile << std::endl;
+
+  for(unsigned int eI = 0; eI < offsets->size(); ++eI){
+    outFile << eI << " " << (*offsets)[eI] << std::endl;
+  }
+
+  outFile.close();
+  return true;
+}
+
+inline bool readEventIndex(const std::string inFileName, std::vector<int>* header, unsigned long long* fileSize, std::string* fileMD5, std::vector<unsigned long long>* offsets)
+{
+  std::ifstream inFile(inFileName.c_str());
+  if(!inFile.is_open()){
+    std::cout << "READEVENTINDEX ERROR - Cannot open \'" << inFileName << "\'. return false" << std::endl;
+    return false;
+  }
+
+  header->clear();
+  offsets->clear();
+
+  //Header is read as its own line so an index w/o inFileSize cannot pick up the first event line in its place
+  std::string headerStr;
+  std::getline(inFile, headerStr);
+  std::stringstream headerStream(headerStr);
+  for(unsigned int hI = 0; hI < 4; ++hI){
+    int tempVal;
+    if(!(headerStream >> tempVal)){
+      std::cout << "READEVENTINDEX ERROR - \'" << inFileName << "\' is missing header values. return false" << std::endl;
+      return false;
+    }
+    header->push_back(tempVal);
+  }
+  if(!(headerStream >> (*fileSize))){
+    std::cout << "READEVENTINDEX ERROR - \'" << inFileName << "\' has no input file size; rebuild it w/ sphenixADCIndexer. return false" << std::endl;
+    return false;
+  }
+  if(!(headerStream >> (*fileMD5))) (*fileMD5) = "";
+
+  unsigned int eventI;
+  unsigned long long offset;
+  while(inFile >> eventI >> offset){
+    if(eventI != offsets->size()){
+      std::cout << "READEVENTINDEX ERROR - \'" << inFileName << "\' has event " << eventI << " out of order (expected " << offsets->size() << "). return false" << std::endl;
+      return false;
+    }
+    offsets->push_back(offset);
+  }
+
+  inFile.close();
+  return true;
+}
+
+#endif
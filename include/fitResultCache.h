@@ -0,0 +1,79 @@
+#ifndef FITRESULTCACHE_H
+#define FITRESULTCACHE_H
+
+//cpp
+#include <string>
+#include <vector>
+
+//ROOT
+#include "TFile.h"
+#include "TTree.h"
+
+//Per-(channel, event) pulse-fit results, stored in <cacheDir>/fitCache_<key>.root
+//key is an md5 of the input file contents + a fit tag, so changing presentation config (SAVEEXT, LINRESMIN/MAX, channel range) reuses results
+//The md5 is one extra full read of the input unless inFileMD5 is given (sphenixADCIndexer stores it in the event index for shards)
+//Bump the fit tag whenever the fit function, initial params or limits change
+//Cached results stay on disk - Load only builds a TTree index on (event, channel) + Get reads single entries
+//New fits are appended to a per-process pending file (<cache>.new<host>_<pid>) as they come, so memory stays flat + a crash loses at most the unsaved baskets;
+//Write merges it into the cache under a lock, along w/ pending files left by crashed runs
+class fitResultCache
+{
+ public:
+  fitResultCache(const std::string inCacheDir, const std::string inFileName, const std::string inFitTag, const std::string inFileMD5 = "");
+  ~fitResultCache();
+
+  bool Load();
+  bool Get(const int channel, const int event, std::vector<double>* params, std::vector<double>* paramErrs, double* chi2, int* ndf, int* status);
+  void Add(const int channel, const int event, std::vector<double>* params, std::vector<double>* paramErrs, const double chi2, const int ndf, const int status);
+  bool Write();
+
+  std::string GetKey(){return m_key;}
+  std::string GetCacheFileName(){return m_cacheFileName;}
+  unsigned long long GetNLoaded(){return m_nLoaded;}
+  unsigned long long GetNHit(){return m_nHit;}
+  unsigned long long GetNAdded(){return m_nAdded;}
+
+ private:
+  static const int nMaxParam = 20;
+
+  struct fitResult{
+    int nPar;
+    double params[nMaxParam];
+    double paramErrs[nMaxParam];
+    double chi2;
+    int ndf;
+    int status;
+  };
+
+  TTree* openCacheTree(const std::string inFileName, TFile** cacheFile_p);
+  void setBranches(TTree* inTree_p, const bool doCreate);
+  void closeCacheFile();
+  bool openPendingFile();
+  void closePendingFile();
+  int lockPendingFile(const std::string pendingFileName, const bool doWait);
+  std::vector<std::string> findOrphanPendingFiles(std::vector<int>* lockFDs);
+
+  std::string m_cacheDir;
+  std::string m_key;
+  std::string m_cacheFileName;
+  TFile* m_cacheFile_p;
+  TTree* m_cacheTree_p;
+  bool m_hasStatus;
+
+  //Held (flock on <pending>.lock) from the first Add until Write, so other runs can tell a live pending file from a crashed run's
+  std::string m_pendingFileName;
+  TFile* m_pendingFile_p;
+  TTree* m_pendingTree_p;
+  int m_pendingLockFD;
+
+  //Branch buffers shared by the read + write trees
+  int m_channel;
+  int m_event;
+  fitResult m_buffer;
+
+  unsigned long long m_nLoaded;
+  unsigned long long m_nHit;
+  unsigned long long m_nAdded;
+};
+
+#endif
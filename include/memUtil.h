@@ -0,0 +1,27 @@
+#ifndef MEMUTIL_H
+#define MEMUTIL_H
+
+//c+cpp
+#include <fstream>
+#include <sys/resource.h>
+#include <unistd.h>
+
+//Peak resident set size of this process in MB (linux ru_maxrss is in kB)
+inline double getPeakRSSMB()
+{
+  struct rusage usage;
+  if(getrusage(RUSAGE_SELF, &usage) != 0) return -1;
+  return ((double)usage.ru_maxrss)/1024.;
+}
+
+//Current resident set size in MB from /proc/self/statm; -1 if unavailable
+inline double getCurrentRSSMB()
+{
+  std::ifstream statmFile("/proc/self/statm");
+  long totalPages = 0;
+  long residentPages = 0;
+  if(!(statmFile >> totalPages >> residentPages)) return -1;
+  return ((double)residentPages)*((double)sysconf(_SC_PAGESIZE))/(1024.*1024.);
+}
+
+#endif
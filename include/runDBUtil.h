@@ -0,0 +1,284 @@
+#ifndef RUNDBUTIL_H
+#define RUNDBUTIL_H
+
+//c+cpp
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <string>
+#include <sys/file.h>
+#include <unistd.h>
+#include <vector>
+
+//ROOT
+#include "TDatime.h"
+#include "TFile.h"
+#include "TH1F.h"
+#include "TTree.h"
+#include "TTreeIndex.h"
+
+//Local
+#include "include/adcResponseUtil.h"
+#include "include/checkMakeDir.h"
+
+//Cross-run summary store: one runSummaryTree entry per (run, channel) in a single ROOT file
+//Branches are read column-wise, so trend queries touch only the channel + requested columns, not the per-run output files
+//The tree is saved w/ a (channel, runDate) index, so a query reads only the matching entries
+const Int_t nRunDBMaxSteps = 100;
+const Int_t nRunDBMaxStr = 512;
+
+struct runDBEntry{
+  Char_t runFileName[nRunDBMaxStr];
+  Int_t runDate;
+  Int_t runTime;
+  Int_t channel;
+  Int_t nSteps;
+  Float_t stepMean[nRunDBMaxSteps];
+  Float_t stepMeanErr[nRunDBMaxSteps];
+  Float_t slope;
+  Float_t intercept;
+  Int_t nPulse;
+  Int_t nFitFail;
+  Int_t nEmptyStep;
+};
+
+inline void setRunDBBranches(TTree* inTree_p, runDBEntry* entry, const bool doCreate)
+{
+  if(doCreate){
+    inTree_p->Branch("runFileName", entry->runFileName, "runFileName/C");
+    inTree_p->Branch("runDate", &(entry->runDate), "runDate/I");
+    inTree_p->Branch("runTime", &(entry->runTime), "runTime/I");
+    inTree_p->Branch("channel", &(entry->channel), "channel/I");
+    inTree_p->Branch("nSteps", &(entry->nSteps), "nSteps/I");
+    inTree_p->Branch("stepMean", entry->stepMean, "stepMean[nSteps]/F");
+    inTree_p->Branch("stepMeanErr", entry->stepMeanErr, "stepMeanErr[nSteps]/F");
+    inTree_p->Branch("slope", &(entry->slope), "slope/F");
+    inTree_p->Branch("intercept", &(entry->intercept), "intercept/F");
+    inTree_p->Branch("nPulse", &(entry->nPulse), "nPulse/I");
+    inTree_p->Branch("nFitFail", &(entry->nFitFail), "nFitFail/I");
+    inTree_p->Branch("nEmptyStep", &(entry->nEmptyStep), "nEmptyStep/I");
+  }
+  else{
+    inTree_p->SetBranchAddress("runFileName", entry->runFileName);
+    inTree_p->SetBranchAddress("runDate", &(entry->runDate));
+    inTree_p->SetBranchAddress("runTime", &(entry->runTime));
+    inTree_p->SetBranchAddress("channel", &(entry->channel));
+    inTree_p->SetBranchAddress("nSteps", &(entry->nSteps));
+    inTree_p->SetBranchAddress("stepMean", entry->stepMean);
+    inTree_p->SetBranchAddress("stepMeanErr", entry->stepMeanErr);
+    inTree_p->SetBranchAddress("slope", &(entry->slope));
+    inTree_p->SetBranchAddress("intercept", &(entry->intercept));
+    inTree_p->SetBranchAddress("nPulse", &(entry->nPulse));
+    inTree_p->SetBranchAddress("nFitFail", &(entry->nFitFail));
+    inTree_p->SetBranchAddress("nEmptyStep", &(entry->nEmptyStep));
+  }
+
+  return;
+}
+
+//Weighted (1/err^2) least squares of mean vs. step over non-empty steps; unweighted if any error is 0
+inline void fitRunDBLine(runDBEntry* entry)
+{
+  bool doWeight = true;
+  for(Int_t sI = 0; sI < entry->nSteps; ++sI){
+    if(entry->stepMean[sI] != 0 && entry->stepMeanErr[sI] <= 0) doWeight = false;
+  }
+
+  double sumW = 0, sumX = 0, sumY = 0, sumXX = 0, sumXY = 0;
+  for(Int_t sI = 0; sI < entry->nSteps; ++sI){
+    if(entry->stepMean[sI] == 0 && entry->stepMeanErr[sI] == 0) continue;
+
+    double weight = 1.;
+    if(doWeight) weight = 1./(entry->stepMeanErr[sI]*entry->stepMeanErr[sI]);
+
+    sumW += weight;
+    sumX += weight*sI;
+    sumY += weight*entry->stepMean[sI];
+    sumXX += weight*sI*sI;
+    sumXY += weight*sI*entry->stepMean[sI];
+  }
+
+  const double denom = sumW*sumXX - sumX*sumX;
+  if(denom == 0){
+    entry->slope = 0;
+    entry->intercept = 0;
+    return;
+  }
+
+  entry->slope = (sumW*sumXY - sumX*sumY)/denom;
+  entry->intercept = (sumXX*sumY - sumX*sumXY)/denom;
+
+  return;
+}
+
+//Reads the summary of a finished sphenixADCProcessing/sphenixADCMerge output + appends it to dbFileName
+//A run already in the store (same runFileName + creation time) is skipped; if the file was re-created since (same config re-run the same day),
+//its old entries are replaced. An flock on <dbFileName>.lock serializes concurrent appends
+inline bool appendRunDB(const std::string dbFileName, const std::string runFileName)
+{
+  checkMakeDir check;
+  if(!check.checkFileExt(runFileName, ".root")) return false;
+
+  TFile* runFile_p = new TFile(runFileName.c_str(), "READ");
+  TTree* runParamTree_p = (TTree*)runFile_p->Get("runParamTree");
+  TTree* peakTree_p = (TTree*)runFile_p->Get("adcPeakTree");
+  if(runParamTree_p == nullptr || peakTree_p == nullptr){
+    std::cout << "APPENDRUNDB ERROR - \'" << runFileName << "\' is missing runParamTree/adcPeakTree. return false" << std::endl;
+    runFile_p->Close();
+    delete runFile_p;
+    return false;
+  }
+
+  Int_t nSteps, minChannel, maxChannel;
+  runParamTree_p->SetBranchAddress("nSteps", &nSteps);
+  runParamTree_p->SetBranchAddress("minChannel", &minChannel);
+  runParamTree_p->SetBranchAddress("maxChannel", &maxChannel);
+  runParamTree_p->GetEntry(0);
+
+  if(nSteps > nRunDBMaxSteps){
+    std::cout << "APPENDRUNDB ERROR - nSteps " << nSteps << " exceeds max " << nRunDBMaxSteps << ". return false" << std::endl;
+    runFile_p->Close();
+    delete runFile_p;
+    return false;
+  }
+
+  std::vector<runDBEntry> entries;
+  TDatime creationDate = runFile_p->GetCreationDate();
+
+  for(Int_t cI = minChannel; cI <= maxChannel; ++cI){
+    runDBEntry entry;
+    std::memset(&entry, 0, sizeof(runDBEntry));
+    std::strncpy(entry.runFileName, runFileName.c_str(), nRunDBMaxStr - 1);
+    entry.runDate = creationDate.GetDate();
+    entry.runTime = creationDate.Convert();
+    entry.channel = cI;
+    entry.nSteps = nSteps;
+
+    std::string dirStr = std::to_string(cI);
+    if(cI < 10) dirStr = "0" + dirStr;
+    dirStr = "channel" + dirStr;
+
+    TH1F* response_p = (TH1F*)runFile_p->Get((dirStr + "/adcResponse_" + getADCResponseChannelStr(cI) + "_h").c_str());
+    if(response_p == nullptr){
+      std::cout << "APPENDRUNDB WARNING - \'" << runFileName << "\' has no response for channel " << cI << " (unmerged shard?); skipping channel" << std::endl;
+      continue;
+    }
+
+    for(Int_t sI = 0; sI < nSteps; ++sI){
+      entry.stepMean[sI] = response_p->GetBinContent(sI+1);
+      entry.stepMeanErr[sI] = response_p->GetBinError(sI+1);
+      if(entry.stepMean[sI] == 0 && entry.stepMeanErr[sI] == 0) ++(entry.nEmptyStep);
+    }
+    fitRunDBLine(&entry);
+
+    entries.push_back(entry);
+  }
+
+  //Flag counts per channel from the per-pulse tree, reading only the two needed columns
+  Int_t peakChannel_, fitStatus_ = 0;
+  peakTree_p->SetBranchStatus("*", 0);
+  peakTree_p->SetBranchStatus("channel", 1);
+  peakTree_p->SetBranchAddress("channel", &peakChannel_);
+  const bool hasFitStatus = peakTree_p->GetBranch("fitStatus") != nullptr;
+  if(hasFitStatus){
+    peakTree_p->SetBranchStatus("fitStatus", 1);
+    peakTree_p->SetBranchAddress("fitStatus", &fitStatus_);
+  }
+
+  const Long64_t nPeakEntries = peakTree_p->GetEntries();
+  for(Long64_t entry = 0; entry < nPeakEntries; ++entry){
+    peakTree_p->GetEntry(entry);
+
+    for(auto & dbEntry : entries){
+      if(dbEntry.channel != peakChannel_) continue;
+      ++(dbEntry.nPulse);
+      if(fitStatus_ != 0) ++(dbEntry.nFitFail);
+      break;
+    }
+  }
+
+  runFile_p->Close();
+  delete runFile_p;
+
+  if(entries.size() == 0){
+    std::cout << "APPENDRUNDB ERROR - \'" << runFileName << "\' gave no channel summaries. return false" << std::endl;
+    return false;
+  }
+
+  const std::string lockFileName = dbFileName + ".lock";
+  int lockFD = open(lockFileName.c_str(), O_CREAT | O_RDWR, 0644);
+  if(lockFD < 0 || flock(lockFD, LOCK_EX) != 0){
+    std::cout << "APPENDRUNDB ERROR - Cannot lock \'" << lockFileName << "\'. return false" << std::endl;
+    if(lockFD >= 0) close(lockFD);
+    return false;
+  }
+
+  TFile* dbFile_p = new TFile(dbFileName.c_str(), "UPDATE");
+  TTree* dbTree_p = (TTree*)dbFile_p->Get("runSummaryTree");
+  runDBEntry dbEntry;
+  bool isDuplicate = false;
+
+  if(dbTree_p == nullptr){
+    dbFile_p->cd();
+    dbTree_p = new TTree("runSummaryTree", "");
+    setRunDBBranches(dbTree_p, &dbEntry, true);
+  }
+  else{
+    setRunDBBranches(dbTree_p, &dbEntry, false);
+
+    bool isStale = false;
+    TBranch* fileNameBranch_p = dbTree_p->GetBranch("runFileName");
+    TBranch* runTimeBranch_p = dbTree_p->GetBranch("runTime");
+    const Long64_t nDBEntries = dbTree_p->GetEntries();
+    for(Long64_t entry = 0; entry < nDBEntries; ++entry){
+      fileNameBranch_p->GetEntry(entry);
+      if(runFileName != dbEntry.runFileName) continue;
+
+      runTimeBranch_p->GetEntry(entry);
+      if(dbEntry.runTime == entries[0].runTime) isDuplicate = true;
+      else isStale = true;
+    }
+
+    //Rebuild the tree w/o the stale entries; the new summary is appended below
+    if(!isDuplicate && isStale){
+      std::cout << "APPENDRUNDB - '" << runFileName << "' was re-created since it was added to '" << dbFileName << "'; replacing its summary" << std::endl;
+
+      dbFile_p->cd();
+      TTree* newTree_p = dbTree_p->CloneTree(0);
+      for(Long64_t entry = 0; entry < nDBEntries; ++entry){
+	dbTree_p->GetEntry(entry);
+	if(runFileName == dbEntry.runFileName) continue;
+	newTree_p->Fill();
+      }
+
+      //~TTree resets the branch addresses of its clones, so newTree_p is re-pointed at dbEntry before the new summary is filled
+      delete dbTree_p;
+      dbFile_p->Delete("runSummaryTree;*");
+      dbTree_p = newTree_p;
+      setRunDBBranches(dbTree_p, &dbEntry, false);
+    }
+  }
+
+  if(isDuplicate) std::cout << "APPENDRUNDB - \'" << runFileName << "\' already in \'" << dbFileName << "\'; skipping" << std::endl;
+  else{
+    for(auto const & entry : entries){
+      dbEntry = entry;
+      dbTree_p->Fill();
+    }
+    dbTree_p->BuildIndex("channel", "runDate");
+
+    dbFile_p->cd();
+    dbTree_p->Write("", TObject::kOverwrite);
+    std::cout << "APPENDRUNDB - Added " << entries.size() << " channels from \'" << runFileName << "\' to \'" << dbFileName << "\'" << std::endl;
+  }
+
+  dbFile_p->Close();
+  delete dbFile_p;
+
+  flock(lockFD, LOCK_UN);
+  close(lockFD);
+
+  return true;
+}
+
+#endif
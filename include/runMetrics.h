@@ -0,0 +1,275 @@
+#ifndef RUNMETRICS_H
+#define RUNMETRICS_H
+
+//c+cpp
+#include <chrono>
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+//Local
+#include "include/memUtil.h"
+
+//Throughput + per-stage timing for a processing run
+//If a file name is given, a Prometheus text-format snapshot is rewritten every interval seconds (tmp file + rename, so a scraper never sees a partial file)
+//Point node_exporter's textfile collector (or any local monitor) at it; a stale sphenixadc_last_update_timestamp_seconds means the run is stalled
+class runMetrics
+{
+ public:
+  enum stage{kRead = 0, kFit, kWrite, kRender, kFinalize, nStages};
+  //Pipeline queues: reader -> fit, fit -> writer
+  enum queue{kReadQueue = 0, kWriteQueue, nQueues};
+
+  runMetrics(const std::string inFileName, const double inIntervalSec, const long long inNEventTarget, const std::string inInputName, const std::string inOutputName)
+  {
+    m_fileName = inFileName;
+    m_intervalSec = inIntervalSec;
+    m_nEventTarget = inNEventTarget;
+    m_inputName = inInputName;
+    m_outputName = inOutputName;
+
+    m_nEvent = 0;
+    m_nFit = 0;
+    m_nFitCached = 0;
+    for(int sI = 0; sI < nStages; ++sI){
+      m_stageSec[sI] = 0;
+    }
+    for(int qI = 0; qI < nQueues; ++qI){
+      m_queueDepth[qI] = -1;
+      m_queueCapacity[qI] = -1;
+      m_nQueuePushWait[qI] = 0;
+      m_nQueuePopWait[qI] = 0;
+    }
+
+    m_start = std::chrono::steady_clock::now();
+    m_lastWriteSec = 0;
+    m_lastWriteNEvent = 0;
+    m_lastWriteNFit = 0;
+    return;
+  }
+  ~runMetrics(){}
+
+  //Seconds since construction
+  double Now(){return std::chrono::duration<double>(std::chrono::steady_clock::now() - m_start).count();}
+
+  //Adds the time since stageStart (from Now()) to the stage; returns the current time so stages can be chained
+  double AddStageTime(const int stageI, const double stageStart)
+  {
+    const double now = Now();
+    m_stageSec[stageI] += now - stageStart;
+    return now;
+  }
+
+  void AddEvent(){++m_nEvent; return;}
+  void AddFit(const bool isCached)
+  {
+    ++m_nFit;
+    if(isCached) ++m_nFitCached;
+    return;
+  }
+
+  void SetQueueState(const int queueI, const long long depth, const long long capacity, const unsigned long long nPushWait, const unsigned long long nPopWait)
+  {
+    m_queueDepth[queueI] = depth;
+    m_queueCapacity[queueI] = capacity;
+    m_nQueuePushWait[queueI] = nPushWait;
+    m_nQueuePopWait[queueI] = nPopWait;
+    return;
+  }
+
+  //Cheap when no file is set or the interval has not elapsed - call once per event
+  void Update()
+  {
+    if(m_fileName.size() == 0) return;
+
+    const double now = Now();
+    if(now - m_lastWriteSec < m_intervalSec) return;
+
+    write(now, false);
+    return;
+  }
+
+  //Final snapshot w/ sphenixadc_done 1
+  void Finish()
+  {
+    if(m_fileName.size() != 0) write(Now(), true);
+    return;
+  }
+
+  void PrintSummary()
+  {
+    const double elapsed = Now();
+    std::cout << "Run metrics: " << m_nEvent << " events, " << m_nFit << " fits (" << m_nFitCached << " from cache) in " << elapsed << " s";
+    if(elapsed > 0) std::cout << " (" << m_nEvent/elapsed << " events/s, " << m_nFit/elapsed << " fits/s)";
+    std::cout << std::endl;
+
+    double stageSum = 0;
+    std::cout << " Stage shares:";
+    for(int sI = 0; sI < nStages; ++sI){
+      stageSum += m_stageSec[sI];
+      std::cout << " " << stageName(sI) << "=" << std::setprecision(3) << share(m_stageSec[sI], elapsed);
+    }
+    std::cout << " other=" << share(elapsed - stageSum, elapsed) << std::setprecision(6) << std::endl;
+    return;
+  }
+
+ private:
+  std::string stageName(const int stageI)
+  {
+    const std::string names[nStages] = {"read", "fit", "write", "render", "finalize"};
+    return names[stageI];
+  }
+
+  std::string queueName(const int queueI)
+  {
+    const std::string names[nQueues] = {"read", "write"};
+    return names[queueI];
+  }
+
+  double share(const double sec, const double elapsed){return elapsed > 0 ? sec/elapsed : 0;}
+
+  //Label values are quoted in the text format; backslash, double quote + newline must be escaped or the scraper rejects the whole file
+  std::string escapeLabel(const std::string inStr)
+  {
+    std::string outStr;
+    for(auto const & c : inStr){
+      if(c == '\\') outStr += "\\\\";
+      else if(c == '"') outStr += "\\\"";
+      else if(c == '\n') outStr += "\\n";
+      else outStr += c;
+    }
+    return outStr;
+  }
+
+  void writeMetric(std::ofstream* outFile_p, const std::string name, const std::string type, const std::string help, const double val)
+  {
+    (*outFile_p) << "# HELP " << name << " " << help << std::endl;
+    (*outFile_p) << "# TYPE " << name << " " << type << std::endl;
+    (*outFile_p) << name << " " << val << std::endl;
+    return;
+  }
+
+  //One series per queue that has been set, labeled queue="read"|"write"
+  void writeQueueMetric(std::ofstream* outFile_p, const std::string name, const std::string type, const std::string help, const double vals[nQueues])
+  {
+    (*outFile_p) << "# HELP " << name << " " << help << std::endl;
+    (*outFile_p) << "# TYPE " << name << " " << type << std::endl;
+    for(int qI = 0; qI < nQueues; ++qI){
+      if(m_queueCapacity[qI] < 0) continue;
+      (*outFile_p) << name << "{queue=\"" << queueName(qI) << "\"} " << vals[qI] << std::endl;
+    }
+    return;
+  }
+
+  void write(const double now, const bool isDone)
+  {
+    const double elapsed = now;
+    const double dt = now - m_lastWriteSec;
+    const double eventsPerSec = dt > 0 ? (m_nEvent - m_lastWriteNEvent)/dt : 0;
+    const double fitsPerSec = dt > 0 ? (m_nFit - m_lastWriteNFit)/dt : 0;
+    const double avgEventsPerSec = elapsed > 0 ? m_nEvent/elapsed : 0;
+    double eta = -1;
+    if(isDone) eta = 0;
+    else if(avgEventsPerSec > 0) eta = (m_nEventTarget - m_nEvent)/avgEventsPerSec;
+
+    const std::string tmpFileName = m_fileName + ".tmp";
+    std::ofstream outFile(tmpFileName.c_str());
+    if(!outFile.is_open()){
+      std::cout << "RUNMETRICS WARNING - Cannot write \'" << tmpFileName << "\'; metrics disabled" << std::endl;
+      m_fileName = "";
+      return;
+    }
+    outFile << std::setprecision(10);
+
+    outFile << "# HELP sphenixadc_run_info Input + output of this run" << std::endl;
+    outFile << "# TYPE sphenixadc_run_info gauge" << std::endl;
+    outFile << "sphenixadc_run_info{input=\"" << escapeLabel(m_inputName) << "\",output=\"" << escapeLabel(m_outputName) << "\"} 1" << std::endl;
+
+    writeMetric(&outFile, "sphenixadc_events_processed_total", "counter", "Events fit + written", m_nEvent);
+    writeMetric(&outFile, "sphenixadc_events_target", "gauge", "Events this run (or shard) will process", m_nEventTarget);
+    writeMetric(&outFile, "sphenixadc_events_per_second", "gauge", "Event rate since the previous snapshot", eventsPerSec);
+    writeMetric(&outFile, "sphenixadc_events_per_second_avg", "gauge", "Event rate since the start of the run", avgEventsPerSec);
+    writeMetric(&outFile, "sphenixadc_fits_total", "counter", "Pulse fits incl. those reused from the fit cache", m_nFit);
+    writeMetric(&outFile, "sphenixadc_fits_cached_total", "counter", "Pulse fits reused from the fit cache", m_nFitCached);
+    writeMetric(&outFile, "sphenixadc_fits_per_second", "gauge", "Fit rate since the previous snapshot", fitsPerSec);
+
+    double stageSum = 0;
+    outFile << "# HELP sphenixadc_stage_seconds_total Wall time per stage; read + write are time waiting on the reader + writer threads when pipelined" << std::endl;
+    outFile << "# TYPE sphenixadc_stage_seconds_total counter" << std::endl;
+    for(int sI = 0; sI < nStages; ++sI){
+      stageSum += m_stageSec[sI];
+      outFile << "sphenixadc_stage_seconds_total{stage=\"" << stageName(sI) << "\"} " << m_stageSec[sI] << std::endl;
+    }
+    outFile << "sphenixadc_stage_seconds_total{stage=\"other\"} " << elapsed - stageSum << std::endl;
+
+    outFile << "# HELP sphenixadc_stage_share Fraction of elapsed wall time per stage" << std::endl;
+    outFile << "# TYPE sphenixadc_stage_share gauge" << std::endl;
+    for(int sI = 0; sI < nStages; ++sI){
+      outFile << "sphenixadc_stage_share{stage=\"" << stageName(sI) << "\"} " << share(m_stageSec[sI], elapsed) << std::endl;
+    }
+    outFile << "sphenixadc_stage_share{stage=\"other\"} " << share(elapsed - stageSum, elapsed) << std::endl;
+
+    bool hasQueue = false;
+    double queueDepth[nQueues], queueCapacity[nQueues], nQueuePushWait[nQueues], nQueuePopWait[nQueues];
+    for(int qI = 0; qI < nQueues; ++qI){
+      if(m_queueCapacity[qI] >= 0) hasQueue = true;
+      queueDepth[qI] = m_queueDepth[qI];
+      queueCapacity[qI] = m_queueCapacity[qI];
+      nQueuePushWait[qI] = m_nQueuePushWait[qI];
+      nQueuePopWait[qI] = m_nQueuePopWait[qI];
+    }
+    if(hasQueue){
+      writeQueueMetric(&outFile, "sphenixadc_queue_depth", "gauge", "Items waiting in the queue; read = decoded events for the fit stage, write = fit results for the writer", queueDepth);
+      writeQueueMetric(&outFile, "sphenixadc_queue_capacity", "gauge", "Queue slots; read = PIPELINEDEPTH, write = PIPELINEDEPTH x channels", queueCapacity);
+      writeQueueMetric(&outFile, "sphenixadc_queue_push_waits_total", "counter", "Times the producer blocked on a full queue (consumer-bound)", nQueuePushWait);
+      writeQueueMetric(&outFile, "sphenixadc_queue_pop_waits_total", "counter", "Times the consumer blocked on an empty queue (producer-bound)", nQueuePopWait);
+    }
+
+    //Base units per Prometheus convention; skipped where RSS cannot be read (-1 from memUtil)
+    const double currentRSSMB = getCurrentRSSMB();
+    const double peakRSSMB = getPeakRSSMB();
+    if(currentRSSMB >= 0) writeMetric(&outFile, "sphenixadc_rss_bytes", "gauge", "Current resident set size", currentRSSMB*1024.*1024.);
+    if(peakRSSMB >= 0) writeMetric(&outFile, "sphenixadc_peak_rss_bytes", "gauge", "Peak resident set size", peakRSSMB*1024.*1024.);
+    writeMetric(&outFile, "sphenixadc_elapsed_seconds", "gauge", "Wall time since processing started", elapsed);
+    writeMetric(&outFile, "sphenixadc_eta_seconds", "gauge", "Estimated seconds to finish at the average rate; -1 if unknown", eta);
+    writeMetric(&outFile, "sphenixadc_last_update_timestamp_seconds", "gauge", "Unix time of this snapshot", (double)std::time(nullptr));
+    writeMetric(&outFile, "sphenixadc_done", "gauge", "1 once the run has finished", isDone ? 1 : 0);
+
+    outFile.close();
+    if(std::rename(tmpFileName.c_str(), m_fileName.c_str()) != 0){
+      std::cout << "RUNMETRICS WARNING - Cannot rename \'" << tmpFileName << "\' to \'" << m_fileName << "\'; metrics disabled" << std::endl;
+      m_fileName = "";
+      return;
+    }
+
+    m_lastWriteSec = now;
+    m_lastWriteNEvent = m_nEvent;
+    m_lastWriteNFit = m_nFit;
+    return;
+  }
+
+  std::string m_fileName;
+  double m_intervalSec;
+  long long m_nEventTarget;
+  std::string m_inputName;
+  std::string m_outputName;
+
+  long long m_nEvent;
+  long long m_nFit;
+  long long m_nFitCached;
+  double m_stageSec[nStages];
+  long long m_queueDepth[nQueues];
+  long long m_queueCapacity[nQueues];
+  unsigned long long m_nQueuePushWait[nQueues];
+  unsigned long long m_nQueuePopWait[nQueues];
+
+  std::chrono::steady_clock::time_point m_start;
+  double m_lastWriteSec;
+  long long m_lastWriteNEvent;
+  long long m_lastWriteNFit;
+};
+
+#endif
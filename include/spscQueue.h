@@ -0,0 +1,161 @@
+#ifndef SPSCQUEUE_H
+#define SPSCQUEUE_H
+
+//cpp
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//Bounded lock-free single-producer/single-consumer ring between two pipeline stages
+//Slots are allocated once; Push copies into a slot, so fixed-size T moves through w/o per-item allocation
+//Push blocks while full - this is the backpressure that keeps a fast reader from running ahead of the fits
+//Both sides spin briefly, then sleep on a condition variable; the mutex is only touched when a side actually blocks
+//FIFO order is kept, so the consumer commits results in input order
+template <typename T>
+class spscQueue
+{
+ public:
+  spscQueue(const unsigned int inCapacity) : m_slots(inCapacity + 1), m_head(0), m_tail(0), m_closed(false), m_pushWaiting(false), m_popWaiting(false), m_nPushWait(0), m_nPopWait(0){}
+  ~spscQueue(){}
+
+  //Producer side
+  bool TryPush(const T& item)
+  {
+    if(!pushSlot(item)) return false;
+    wake(&m_popWaiting, &m_notEmpty);
+    return true;
+  }
+
+  void Push(const T& item)
+  {
+    for(unsigned int sI = 0; sI < nSpin; ++sI){
+      if(TryPush(item)) return;
+      std::this_thread::yield();
+    }
+
+    ++m_nPushWait;
+    std::unique_lock<std::mutex> lock(m_mutex);
+    block(&lock, &m_pushWaiting, &m_notFull, [&]{return pushSlot(item);});
+    lock.unlock();
+    wake(&m_popWaiting, &m_notEmpty);
+    return;
+  }
+
+  //No more pushes; Pop drains what is left then returns false
+  void Close()
+  {
+    m_closed.store(true, std::memory_order_release);
+    wake(&m_popWaiting, &m_notEmpty);
+    return;
+  }
+
+  //Consumer side
+  bool TryPop(T* item)
+  {
+    if(!popSlot(item)) return false;
+    wake(&m_pushWaiting, &m_notFull);
+    return true;
+  }
+
+  bool Pop(T* item)
+  {
+    for(unsigned int sI = 0; sI < nSpin; ++sI){
+      if(TryPop(item)) return true;
+      //Check closed before the final retry so an item pushed just before Close is not dropped
+      if(m_closed.load(std::memory_order_acquire)) return TryPop(item);
+      std::this_thread::yield();
+    }
+
+    ++m_nPopWait;
+    bool popped = false;
+    std::unique_lock<std::mutex> lock(m_mutex);
+    block(&lock, &m_popWaiting, &m_notEmpty, [&]{
+	popped = popSlot(item);
+	if(!popped && m_closed.load(std::memory_order_acquire)) popped = popSlot(item);
+	return popped || m_closed.load(std::memory_order_acquire);
+      });
+    lock.unlock();
+    if(popped) wake(&m_pushWaiting, &m_notFull);
+    return popped;
+  }
+
+  //Approximate when read from a third thread
+  unsigned int GetDepth()
+  {
+    const std::size_t head = m_head.load(std::memory_order_acquire);
+    const std::size_t tail = m_tail.load(std::memory_order_acquire);
+    return (unsigned int)((tail + m_slots.size() - head)%m_slots.size());
+  }
+  unsigned int GetCapacity(){return m_slots.size() - 1;}
+  //Times a side went to sleep (once per blocking episode); many push waits = consumer-bound, many pop waits = producer-bound
+  unsigned long long GetNPushWait(){return m_nPushWait.load(std::memory_order_relaxed);}
+  unsigned long long GetNPopWait(){return m_nPopWait.load(std::memory_order_relaxed);}
+
+ private:
+  static const unsigned int nSpin = 64;
+
+  std::size_t increment(const std::size_t index){return (index + 1)%m_slots.size();}
+
+  //Ring ops w/o the wake, so they can run as a wait predicate under m_mutex
+  bool pushSlot(const T& item)
+  {
+    const std::size_t tail = m_tail.load(std::memory_order_relaxed);
+    const std::size_t next = increment(tail);
+    if(next == m_head.load(std::memory_order_acquire)) return false;
+
+    m_slots[tail] = item;
+    m_tail.store(next, std::memory_order_release);
+    return true;
+  }
+
+  bool popSlot(T* item)
+  {
+    const std::size_t head = m_head.load(std::memory_order_relaxed);
+    if(head == m_tail.load(std::memory_order_acquire)) return false;
+
+    (*item) = m_slots[head];
+    m_head.store(increment(head), std::memory_order_release);
+    return true;
+  }
+
+  //Waiting flag + seq_cst fences on both sides: either the waiter sees the other side's index update, or the other side sees the flag and notifies
+  template <typename Ready>
+  void block(std::unique_lock<std::mutex>* lock, std::atomic<bool>* waiting, std::condition_variable* cv, Ready ready)
+  {
+    waiting->store(true, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    cv->wait(*lock, ready);
+    waiting->store(false, std::memory_order_relaxed);
+    return;
+  }
+
+  void wake(std::atomic<bool>* waiting, std::condition_variable* cv)
+  {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if(!waiting->load(std::memory_order_relaxed)) return;
+
+    //Taking the lock orders this notify after the waiter's predicate check
+    std::lock_guard<std::mutex> lock(m_mutex);
+    cv->notify_one();
+    return;
+  }
+
+  std::vector<T> m_slots;
+  //head + tail on separate cache lines so producer + consumer do not false-share
+  alignas(64) std::atomic<std::size_t> m_head;
+  alignas(64) std::atomic<std::size_t> m_tail;
+  std::atomic<bool> m_closed;
+
+  std::mutex m_mutex;
+  std::condition_variable m_notFull;
+  std::condition_variable m_notEmpty;
+  std::atomic<bool> m_pushWaiting;
+  std::atomic<bool> m_popWaiting;
+
+  std::atomic<unsigned long long> m_nPushWait;
+  std::atomic<unsigned long long> m_nPopWait;
+};
+
+#endif
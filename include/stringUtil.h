@@ -2,24 +2,85 @@
 #define STRINGUTIL_H
 
 //c+cpp
+#include <algorithm>
+#include <charconv>
 #include <ctime>
 #include <iostream>
 #include <string>
+#include <string_view>
 #include <vector>
 
-inline bool isStrSame(std::string inStr1, std::string inStr2)
+//Non-allocating std::string_view helpers - used in the per-line hot path; std::string versions below are thin wrappers
+//Views point into the caller's buffer, so they are only valid while that buffer is alive + unmodified
+
+inline std::string_view strViewTrim(std::string_view inStr, const char trimChar = ' ')
 {
-  if(inStr1.size() != inStr2.size()) return false;
-  if(inStr1.find(inStr2) == std::string::npos) return false;
-  return true;
+  const std::string_view::size_type first = inStr.find_first_not_of(trimChar);
+  if(first == std::string_view::npos) return std::string_view();
+  const std::string_view::size_type last = inStr.find_last_not_of(trimChar);
+  return inStr.substr(first, last - first + 1);
 }
 
-inline std::string removeAllWhiteSpace(std::string inStr)
+//Splits inStr on delim into caller-provided outSpan[0..outMax); returns total token count, which may exceed outMax (extras not stored)
+//skipEmpty == false keeps empty tokens between delimiters but drops a trailing empty token (strToVect behavior)
+//skipEmpty == true drops all empty tokens (commaSepStringToVect behavior, and ' ' runs in the data lines)
+inline std::size_t strViewSplit(std::string_view inStr, const char delim, std::string_view* outSpan, const std::size_t outMax, const bool skipEmpty)
+{
+  std::size_t nTok = 0;
+  std::string_view::size_type pos = 0;
+
+  while(pos < inStr.size()){
+    std::string_view::size_type next = inStr.find(delim, pos);
+    if(next == std::string_view::npos) next = inStr.size();
+
+    if(!skipEmpty || next != pos){
+      if(nTok < outMax) outSpan[nTok] = inStr.substr(pos, next - pos);
+      ++nTok;
+    }
+
+    pos = next + 1;
+  }
+
+  return nTok;
+}
+
+//Same as strViewSplit but appends to a reusable vector; clears it first, capacity is kept across calls
+inline void strViewSplit(std::string_view inStr, const char delim, std::vector<std::string_view>* outVect, const bool skipEmpty)
 {
-  while(inStr.find(" ") != std::string::npos){
-    inStr.replace(inStr.find(" "), 1, "");
+  outVect->clear();
+  std::string_view::size_type pos = 0;
+
+  while(pos < inStr.size()){
+    std::string_view::size_type next = inStr.find(delim, pos);
+    if(next == std::string_view::npos) next = inStr.size();
+
+    if(!skipEmpty || next != pos) outVect->push_back(inStr.substr(pos, next - pos));
+
+    pos = next + 1;
   }
 
+  return;
+}
+
+//Parses leading digits of inStr in given base (accepts 0x/0X prefix for base 16, like std::hex streams); false if no digits parsed
+inline bool strViewToUInt(std::string_view inStr, unsigned int* outVal, const int base = 10)
+{
+  if(base == 16 && inStr.size() > 2 && inStr[0] == '0' && (inStr[1] == 'x' || inStr[1] == 'X')) inStr.remove_prefix(2);
+  std::from_chars_result result = std::from_chars(inStr.data(), inStr.data() + inStr.size(), *outVal, base);
+  return result.ec == std::errc() && result.ptr != inStr.data();
+}
+
+inline bool strViewToInt(std::string_view inStr, int* outVal, const int base = 10)
+{
+  std::from_chars_result result = std::from_chars(inStr.data(), inStr.data() + inStr.size(), *outVal, base);
+  return result.ec == std::errc() && result.ptr != inStr.data();
+}
+
+inline bool isStrSame(std::string_view inStr1, std::string_view inStr2){return inStr1 == inStr2;}
+
+inline std::string removeAllWhiteSpace(std::string inStr)
+{
+  inStr.erase(std::remove(inStr.begin(), inStr.end(), ' '), inStr.end());
   return inStr;
 }
 
@@ -138,25 +199,11 @@ inline std::string getRValStr(const std::string inStr)
   return rVal;
 }
 
-inline std::vector<std::string> commaSepStringToVect(std::string inStr)
+inline std::vector<std::string> commaSepStringToVect(const std::string& inStr)
 {
-  std::vector<std::string> retVect;
-
-  inStr = inStr + ",";
-  while(inStr.find(",,") != std::string::npos){inStr.replace(inStr.find(",,"), 2, ",");}
-  if(inStr.size() != 0){
-    while(inStr.substr(0,1).find(",") != std::string::npos){
-      inStr.replace(0, 1, "");
-      if(inStr.size() == 0) break;
-    }
-  }
-
-  while(inStr.find(",") != std::string::npos){
-    retVect.push_back(inStr.substr(0, inStr.find(",")));
-    inStr.replace(0, inStr.find(",")+1, "");
-  }
-  
-  return retVect;
+  std::vector<std::string_view> viewVect;
+  strViewSplit(inStr, ',', &viewVect, true);
+  return std::vector<std::string>(viewVect.begin(), viewVect.end());
 }
 
 inline bool vectContainsStr(std::string inStr, std::vector<std::string>* inVect)
@@ -199,16 +246,11 @@ inline bool vectContainsInt(int inInt, std::vector<int>* inVect)
   return isInVect;
 }
 
-inline std::vector<std::string> strToVect(std::string inStr)
+inline std::vector<std::string> strToVect(const std::string& inStr)
 {
-  std::vector<std::string> retVect;
-  while(inStr.find(",") != std::string::npos){
-    retVect.push_back(inStr.substr(0, inStr.find(",")));
-    inStr.replace(0, inStr.find(",")+1, "");
-  }
-  if(inStr.size() != 0) retVect.push_back(inStr);
-
-  return retVect;
+  std::vector<std::string_view> viewVect;
+  strViewSplit(inStr, ',', &viewVect, false);
+  return std::vector<std::string>(viewVect.begin(), viewVect.end());
 }
 
 inline std::vector<float> strToVectF(std::string inStr)